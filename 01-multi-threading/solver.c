@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <math.h>
+#include "solver.h"
+
+/* Returns the region holding row i (edge rows belong to the nearest region) */
+static int region(struct solver *s, int i)
+{
+	if (i < 1)
+		i = 1;
+	if (i > s->d - 2)
+		i = s->d - 2;
+	return (i - 1) / REGION;
+}
+
+struct solver *solver_create(double **arr, int d, int n_threads, double p)
+{
+	int i, j;
+
+	/* The stencil needs at least one interior cell */
+	if (d < 3) {
+		fprintf (stderr, "Solver needs an array of at least 3 x 3! \n");
+		exit(1);
+	}
+
+	struct solver *s = (struct solver *)malloc(sizeof(struct solver));
+
+	s->d = d;
+	s->n_threads = n_threads;
+	s->p = p;
+	s->sweeps = 0;
+	s->regions = (d - 2 + REGION - 1) / REGION;
+
+	/* Take a private copy of the starting array (arr and tmp identical) */
+	s->arr = (double **)malloc(d * sizeof(double *));
+	s->tmp = (double **)malloc(d * sizeof(double *));
+	for (i = 0; i < d; i++) {
+		s->arr[i] = (double *)malloc(d * sizeof(double));
+		s->tmp[i] = (double *)malloc(d * sizeof(double));
+		for (j = 0; j < d; j++) {
+			s->arr[i][j] = arr[i][j];
+			s->tmp[i][j] = arr[i][j];
+		}
+	}
+
+	/* Nothing has converged yet - every region starts live */
+	s->resid = (double *)malloc(s->regions * sizeof(double));
+	s->edge = (double *)malloc(2 * s->regions * sizeof(double));
+	s->live = (int *)malloc(s->regions * sizeof(int));
+	for (i = 0; i < s->regions; i++) {
+		s->resid[i] = 0;
+		s->edge[2 * i] = 0;
+		s->edge[2 * i + 1] = 0;
+		s->live[i] = 1;
+	}
+
+	return s;
+}
+
+void solver_set(struct solver *s, int i, int j, double v)
+{
+	/* Edit both copies so the sweep invariant (tmp == arr) still holds */
+	s->arr[i][j] = v;
+	s->tmp[i][j] = v;
+
+	/* Rows i-1, i and i+1 read this cell - wake the regions holding them */
+	s->live[region(s, i - 1)] = 1;
+	s->live[region(s, i)] = 1;
+	s->live[region(s, i + 1)] = 1;
+}
+
+int solver_solve(struct solver *s)
+{
+	/* Define threads, locks, barriers and other variables*/
+	int i, active = 0, flag = 0;
+	pthread_t threads[s->n_threads];
+	pthread_mutex_t locks[1];
+	pthread_barrier_t barrier;
+
+	/* Only sweep if some region was edited since the last solve */
+	for (i = 0; i < s->regions; i++)
+		if (s->live[i])
+			flag = 1;
+	s->sweeps = 0;
+
+	pthread_mutex_init(&locks[0], NULL);
+	pthread_barrier_init(&barrier, NULL, s->n_threads);
+
+	/* Initialise and contract parameters */
+	struct sweep_param params;
+		params.s = s;					// Shared solver handle
+		params.active = &active;		// Shared pointer to active (number of initialised threads)
+		params.flag = &flag;			// Shared pointer to flag
+		params.locks = locks;			// Shared array of locks
+		params.barrier = &barrier;		// Shared barrier
+
+	/* Generate child threads */
+	for (i = 0; i < s->n_threads; i++) {
+		if (pthread_create(&threads[i], NULL, sweep, &params)) {
+			fprintf (stderr, "Thread creation failed! \n");
+			exit(1);
+		}
+	}
+
+	/* Wait for all threads to rejoin */
+	for (i = 0; i < s->n_threads; i++)
+		pthread_join(threads[i], NULL);
+
+	pthread_mutex_destroy(&locks[0]);
+	pthread_barrier_destroy(&barrier);
+
+	return s->sweeps;
+}
+
+double solver_residual(struct solver *s)
+{
+	/* Largest change one more full sweep would make (the test relax() stops on) */
+	int i, j;
+	double v, delta = 0;
+	for (i = 1; i < s->d - 1; i++) {
+		for (j = 1; j < s->d - 1; j++) {
+			v = (s->arr[i-1][j] + s->arr[i+1][j] + s->arr[i][j-1] + s->arr[i][j+1]) / 4;
+			if (fabs(v - s->arr[i][j]) > delta)
+				delta = fabs(v - s->arr[i][j]);
+		}
+	}
+	return delta;
+}
+
+void solver_destroy(struct solver *s)
+{
+	int i;
+	for (i = 0; i < s->d; i++) {
+		free(s->arr[i]);
+		free(s->tmp[i]);
+	}
+	free(s->arr);
+	free(s->tmp);
+	free(s->resid);
+	free(s->edge);
+	free(s->live);
+	free(s);
+}
+
+
+void *sweep(void *ptr)
+{
+	/* Create new struct pointer and copy argument value */
+	struct sweep_param *params = (struct sweep_param *)ptr;
+
+	/* Initialise locals and retreive external parameters */
+	int i, j, r, pid, lo, hi;				// Loops: i, j and r | pid: Private ID | lo, hi: region rows
+	int full = 0;							// Thread 0: last sweep covered every region
+	struct solver *s = params->s;			// Shared solver handle
+	double **arr = s->arr;					// Pointer to newest array
+	double **tmp = s->tmp;					// Pointer to older array
+	int *active = params->active;			// Pointer to number of initialised threads
+	int *flag = params->flag;				// Shared flag = 1 while any region is live
+	int d = s->d;							// Dimension of array
+	int threads = s->n_threads;				// Number of threads
+	double p = s->p;						// Precision to be achieved
+	double delta, row;						// Largest change in the current region | in the current row
+	double *edge = s->edge;					// Accumulated change to each region's edge rows
+
+	pthread_mutex_t *locks = params->locks;
+	pthread_barrier_t *barrier = params->barrier;
+
+	/* Register each thread with a private ID */
+	pthread_mutex_lock(&locks[0]);
+		pid = *active;
+		*active += 1;
+	pthread_mutex_unlock(&locks[0]);
+
+	while(1)
+	{
+		/* Wait for thread 0 to publish the live regions */
+		pthread_barrier_wait(barrier);
+		if(*flag == 0)
+			break;		// Break once no region is live
+
+		/* Perform relaxation on allocated live regions */
+		for (r = pid; r < s->regions; r = r + threads) {
+			if (!s->live[r])
+				continue;
+			lo = 1 + r * REGION;
+			hi = lo + REGION < d - 1 ? lo + REGION : d - 1;
+			delta = 0;
+			for (i = lo; i < hi; i++) {
+				row = 0;
+				for (j = 1; j < d - 1; j++) {
+					arr[i][j] = (tmp[i-1][j] + tmp[i+1][j] + tmp[i][j-1] + tmp[i][j+1]) / 4;
+					if (fabs(tmp[i][j] - arr[i][j]) > row)
+						row = fabs(tmp[i][j] - arr[i][j]);
+				}
+				if (row > delta)
+					delta = row;
+				/* Changes to the edge rows add up until the neighbour reads them */
+				if (i == lo)
+					edge[2 * r] += row;
+				if (i == hi - 1)
+					edge[2 * r + 1] += row;
+			}
+			s->resid[r] = delta;
+		}
+
+		/* Wait for all threads to complete computation */
+		pthread_barrier_wait(barrier);
+
+		/* Bring tmp back in line with arr on the swept regions */
+		for (r = pid; r < s->regions; r = r + threads) {
+			if (!s->live[r])
+				continue;
+			lo = 1 + r * REGION;
+			hi = lo + REGION < d - 1 ? lo + REGION : d - 1;
+			for (i = lo; i < hi; i++)
+				for (j = 1; j < d - 1; j++)
+					tmp[i][j] = arr[i][j];
+		}
+
+		/* Wait for all copies before the live set changes */
+		pthread_barrier_wait(barrier);
+
+		/* Region stays live while it moved more than p, or its neighbours' edge rows
+			have moved more than p in total since it last swept */
+		if (pid == 0) {
+			*flag = 0;
+			for (r = 0; r < s->regions; r++) {
+				s->live[r] = s->resid[r] > p
+					|| (r > 0 && edge[2 * (r - 1) + 1] > p)
+					|| (r < s->regions - 1 && edge[2 * (r + 1)] > p);
+				if (s->live[r])
+					*flag = 1;
+			}
+
+			/* Nothing live - stop only if a sweep over every region met p */
+			if (*flag == 0 && !full) {
+				for (r = 0; r < s->regions; r++)
+					s->live[r] = 1;
+				*flag = 1;
+			}
+			full = *flag;
+			for (r = 0; r < s->regions; r++)
+				full = full && s->live[r];
+
+			/* Live regions read their neighbours' edges on the next sweep */
+			for (r = 0; r < s->regions; r++) {
+				if (!s->live[r]) {
+					s->resid[r] = 0;
+					continue;
+				}
+				if (r > 0)
+					edge[2 * (r - 1) + 1] = 0;
+				if (r < s->regions - 1)
+					edge[2 * (r + 1)] = 0;
+			}
+			s->sweeps++;
+		}
+	}
+
+	pthread_exit(NULL);
+
+} /* sweep() */
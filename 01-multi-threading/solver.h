@@ -0,0 +1,42 @@
+#pragma once
+
+#ifndef SOLVER
+# define SOLVER
+
+/* Number of rows per region */
+#define REGION 16
+
+/* Persistent solver handle - keeps the last converged field between solves */
+struct solver {
+	double **arr;		// Last converged array
+	double **tmp;		// Dummy array (kept equal to arr between sweeps)
+	double *resid;		// Largest change seen in each region on its last sweep
+	double *edge;		// edge[2r], edge[2r+1]: change to region r's first / last row since its neighbour last read it
+	int *live;			// live[r] = 1 when region r must be swept again
+	int regions;		// Number of regions
+	int sweeps;			// Sweeps performed by the last solve
+	double p;
+	int d;
+	int n_threads;
+};
+
+/* Solver interface */
+struct solver *solver_create(double **arr, int d, int n_threads, double p);
+void solver_set(struct solver *s, int i, int j, double v);
+int solver_solve(struct solver *s);
+double solver_residual(struct solver *s);
+void solver_destroy(struct solver *s);
+
+/* Multi-threaded function */
+void *sweep(void *p);
+
+/* Parameter structure */
+struct sweep_param {
+	struct solver *s;
+	int *active;
+	int *flag;
+	pthread_mutex_t *locks;
+	pthread_barrier_t *barrier;
+};
+
+#endif
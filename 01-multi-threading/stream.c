@@ -0,0 +1,226 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "stream.h"
+
+/* Returns row i of the grid after 'level' Jacobi steps of the current pass */
+static double *stream_row(struct stream_param *sp, int level, int i)
+{
+	/* Level 0 and the fixed edge rows live in the file itself */
+	if (level == 0 || i == 0 || i == sp->d - 1)
+		return sp->map + (size_t)i * sp->d;
+
+	return sp->ring[level - 1]
+		+ ((size_t)((i - 1) / sp->band % RING) * sp->band + (i - 1) % sp->band) * sp->d;
+}
+
+/* Asks the kernel to start reading rows [lo, hi) of the file in the background */
+static void stream_prefetch(struct stream_param *sp, int lo, int hi)
+{
+	size_t start = (size_t)lo * sp->d * sizeof(double);
+	size_t end = (size_t)hi * sp->d * sizeof(double);
+
+	start -= start % sp->page;
+	if (end > start)
+		madvise((char *)sp->map + start, end - start, MADV_WILLNEED);
+}
+
+void stream_relax(const char *path, int d, int n_threads, int band, double p)
+{
+	/* Define threads, locks, barriers and other variables*/
+	int i, fd, active = 0, flag = 1;
+	double delta = 0;
+	struct stat st;
+	size_t bytes = (size_t)d * d * sizeof(double);
+	pthread_mutex_t locks[1];
+	pthread_cond_t cond;
+	pthread_barrier_t barrier;
+
+	/* Edge rows and columns are fixed - nothing to relax without an interior */
+	if (d < 3)
+		return;
+	if (n_threads < 1 || band < 1) {
+		fprintf (stderr, "Number of threads and band size must be positive! \n");
+		exit(1);
+	}
+	pthread_t threads[n_threads];
+
+	/* Map the grid file - pages are read and written back by the kernel */
+	fd = open(path, O_RDWR);
+	if (fd < 0 || fstat(fd, &st) || (size_t)st.st_size < bytes) {
+		fprintf (stderr, "Cannot open %d x %d grid in %s! \n", d, d, path);
+		exit(1);
+	}
+	double *map = (double *)mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED) {
+		fprintf (stderr, "Memory mapping failed! \n");
+		exit(1);
+	}
+	madvise(map, bytes, MADV_SEQUENTIAL);
+
+	/* Rolling window: RING bands for each of the n_threads steps in a pass */
+	int bands = (d - 2 + band - 1) / band;
+	int *done = (int *)calloc(n_threads, sizeof(int));
+	double **ring = (double **)malloc(n_threads * sizeof(double *));
+	for (i = 0; i < n_threads; i++) {
+		ring[i] = (double *)malloc((size_t)RING * band * d * sizeof(double));
+		if (ring[i] == NULL) {
+			fprintf (stderr, "Band allocation failed! \n");
+			exit(1);
+		}
+	}
+
+	pthread_mutex_init(&locks[0], NULL);
+	pthread_cond_init(&cond, NULL);
+	pthread_barrier_init(&barrier, NULL, n_threads);
+
+	/* Initialise and contract parameters */
+	struct stream_param params;
+		params.map = map;				// Shared pointer to mapped grid
+		params.ring = ring;				// Shared rolling windows
+		params.done = done;				// Shared progress of each stage
+		params.active = &active;		// Shared pointer to active (number of initialised threads)
+		params.flag = &flag;			// Shared pointer to flag
+		params.delta = &delta;			// Shared largest change
+		params.locks = locks;			// Shared array of locks
+		params.cond = &cond;			// Shared progress condition
+		params.barrier = &barrier;		// Shared barrier
+		params.p = p;					// Precision
+		params.d = d;					// Array dimension
+		params.band = band;				// Rows per band
+		params.bands = bands;			// Number of bands
+		params.n_threads = n_threads;	// Number of threads (steps per pass)
+		params.page = sysconf(_SC_PAGESIZE);
+
+	/* Generate child threads */
+	for (i = 0; i < n_threads; i++) {
+		if (pthread_create(&threads[i], NULL, stream_stage, &params)) {
+			fprintf (stderr, "Thread creation failed! \n");
+			exit(1);
+		}
+	}
+
+	/* Wait for all threads to rejoin */
+	for (i = 0; i < n_threads; i++)
+		pthread_join(threads[i], NULL);
+
+	pthread_mutex_destroy(&locks[0]);
+	pthread_cond_destroy(&cond);
+	pthread_barrier_destroy(&barrier);
+
+	/* Flush the relaxed grid back to disk */
+	msync(map, bytes, MS_SYNC);
+	munmap(map, bytes);
+	close(fd);
+
+	for (i = 0; i < n_threads; i++)
+		free(ring[i]);
+	free(ring);
+	free(done);
+}
+
+
+void *stream_stage(void *ptr)
+{
+	/* Create new struct pointer and copy argument value */
+	struct stream_param *sp = (struct stream_param *)ptr;
+
+	/* Initialise locals and retreive external parameters */
+	int i, j, b, pid, lo, hi, wait;		// Loops: i, j and b | pid: Private ID (= step) | lo, hi: band rows
+	int *active = sp->active;			// Pointer to number of initialised threads
+	int *flag = sp->flag;				// Shared flag = 1 when precision not met
+	int *done = sp->done;				// Bands finished by each stage
+	int d = sp->d;						// Dimension of array
+	int band = sp->band;				// Rows per band
+	int bands = sp->bands;				// Number of bands
+	int threads = sp->n_threads;		// Number of threads
+	double delta = 0;					// Largest change seen by the last stage
+	double *in, *up, *down, *out;		// Rows read from step pid, row written at step pid + 1
+
+	pthread_mutex_t *locks = sp->locks;
+	pthread_barrier_t *barrier = sp->barrier;
+
+	/* Register each thread with a private ID */
+	pthread_mutex_lock(&locks[0]);
+		pid = *active;
+		*active += 1;
+	pthread_mutex_unlock(&locks[0]);
+
+	while(1)
+	{
+		/* Wait for all threads to arrive */
+		pthread_barrier_wait(barrier);
+		if(*flag == 0)
+			break;		// Break once the last pass met precision
+
+		/* Stage pid applies step pid + 1 to every band, one band behind stage pid - 1 */
+		for (b = 0; b < bands; b++) {
+			lo = 1 + b * band;
+			hi = lo + band < d - 1 ? lo + band : d - 1;
+
+			/* Need band b + 1 from the previous step, and a free slot in our window */
+			wait = b + 2 < bands ? b + 2 : bands;
+			pthread_mutex_lock(&locks[0]);
+			while ((pid > 0 && done[pid - 1] < wait)
+				|| (pid < threads - 1 && done[pid + 1] < b - RING + 2))
+				pthread_cond_wait(sp->cond, &locks[0]);
+			pthread_mutex_unlock(&locks[0]);
+
+			/* First stage reads the file - start fetching the next bands now */
+			if (pid == 0)
+				stream_prefetch(sp, hi, hi + 2 * band < d ? hi + 2 * band : d);
+
+			for (i = lo; i < hi; i++) {
+				up = stream_row(sp, pid, i - 1);
+				in = stream_row(sp, pid, i);
+				down = stream_row(sp, pid, i + 1);
+				out = stream_row(sp, pid + 1, i);
+				out[0] = in[0];
+				out[d - 1] = in[d - 1];
+				for (j = 1; j < d - 1; j++)
+					out[j] = (up[j] + down[j] + in[j-1] + in[j+1]) / 4;
+
+				/* Last stage measures the change made by the final step */
+				if (pid == threads - 1)
+					for (j = 1; j < d - 1; j++)
+						if (fabs(out[j] - in[j]) > delta)
+							delta = fabs(out[j] - in[j]);
+			}
+
+			/* Last stage writes back the band before; nothing reads it from the file again */
+			if (pid == threads - 1 && b > 0)
+				for (i = lo - band; i < lo; i++)
+					memcpy(sp->map + (size_t)i * d, stream_row(sp, threads, i), d * sizeof(double));
+
+			pthread_mutex_lock(&locks[0]);
+				done[pid]++;
+				pthread_cond_broadcast(sp->cond);
+			pthread_mutex_unlock(&locks[0]);
+		}
+
+		/* Write back the final band */
+		if (pid == threads - 1) {
+			for (i = 1 + (bands - 1) * band; i < d - 1; i++)
+				memcpy(sp->map + (size_t)i * d, stream_row(sp, threads, i), d * sizeof(double));
+			*sp->delta = delta;
+			delta = 0;
+		}
+
+		/* Wait for all threads to complete the pass */
+		pthread_barrier_wait(barrier);
+		if (pid == 0) {
+			*flag = *sp->delta > sp->p;
+			for (i = 0; i < threads; i++)
+				done[i] = 0;
+		}
+	}
+
+	pthread_exit(NULL);
+
+} /* stream_stage() */
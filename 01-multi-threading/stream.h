@@ -0,0 +1,34 @@
+#pragma once
+
+#ifndef STREAM
+# define STREAM
+
+/* Number of bands kept per Jacobi step in the rolling window */
+#define RING 4
+
+/* Out-of-core relaxation of a binary grid file (modified in place) */
+void stream_relax(const char *path, int d, int n_threads, int band, double p);
+
+/* Multi-threaded function - one pipeline stage per thread */
+void *stream_stage(void *p);
+
+/* Parameter structure */
+struct stream_param {
+	double *map;		// Memory-mapped grid (row-major, d x d)
+	double **ring;		// ring[s]: rolling window of bands after step s + 1
+	int *done;			// done[s]: bands finished by stage s this pass
+	int *active;
+	int *flag;
+	double *delta;		// Largest change on the last step of the pass
+	double p;
+	int d;
+	int band;			// Rows per band
+	int bands;			// Number of bands
+	int n_threads;
+	long page;			// System page size
+	pthread_mutex_t *locks;
+	pthread_cond_t *cond;
+	pthread_barrier_t *barrier;
+};
+
+#endif